@@ -34,6 +34,8 @@ namespace gr {
 				(new decimator_impl(num_antennas, sample_rate, symbol_rate));
 		}
 
+		const int decimator_impl::BUF_SIZE;
+
 		decimator_impl::decimator_impl(int num_antennas, float sample_rate, float symbol_rate)
 			: gr::sync_decimator("decimator",
 					gr::io_signature::make(num_antennas, num_antennas, sizeof(gr_complex)),
@@ -49,20 +51,33 @@ namespace gr {
 			// out[:, : #pairs] -> conj
 			// out[:, #pairs :] -> magsq (imag == 0)
 
+			if(d_decim_rate < 1) {
+				throw std::invalid_argument("decimator: sample_rate / symbol_rate must be at least 1");
+			}
+
+			// all buffers are sized here so that work() never allocates;
+			// one buffer always holds a whole number of output items
+			d_buf_size = std::max(BUF_SIZE, d_decim_rate) / d_decim_rate * d_decim_rate;
+
 			const unsigned int alignment = volk_get_alignment();
 			set_alignment(std::max(1, static_cast<int>(alignment / sizeof(gr_complex))));
+			set_max_noutput_items(d_buf_size / d_decim_rate);
+
+			d_in.resize(d_num_antennas, nullptr);
+			d_conj_buf.reserve(d_num_pairs);
+			d_magsq_buf.reserve(d_num_antennas);
 			for(int i = 0; i < d_num_pairs; ++i) {
-				d_conj_buf.push_back((gr_complex*)volk_malloc(8192 * sizeof(gr_complex), alignment));
+				d_conj_buf.emplace_back((gr_complex*)volk_malloc(d_buf_size * sizeof(gr_complex), alignment));
+				if(!d_conj_buf.back()) throw std::bad_alloc();
 			}
 			for(int i = 0; i < d_num_antennas; ++i) {
-				d_magsq_buf.push_back((float*)volk_malloc(8192 * sizeof(float), alignment));
+				d_magsq_buf.emplace_back((float*)volk_malloc(d_buf_size * sizeof(float), alignment));
+				if(!d_magsq_buf.back()) throw std::bad_alloc();
 			}
 		}
 
 		decimator_impl::~decimator_impl()
 		{
-			for(auto &buf : d_conj_buf) volk_free(buf);
-			for(auto &buf : d_magsq_buf) volk_free(buf);
 		}
 
 		int decimator_impl::work(int noutput_items,
@@ -70,19 +85,18 @@ namespace gr {
 				gr_vector_void_star &output_items)
 		{
 			const int nread = noutput_items * d_decim_rate;
-			std::vector<const gr_complex*> in;
 			gr_complex* out = (gr_complex *) output_items[0];
 
 			for(int i = 0; i < d_num_antennas; ++i) {
-				in.push_back((const gr_complex*) input_items[i]);
+				d_in[i] = (const gr_complex*) input_items[i];
 			}
 
 			for(int i = 0, pair = 0; i < d_num_antennas; ++i) {
 				for(int j = i + 1; j < d_num_antennas; ++j, ++pair) {
-					volk_32fc_x2_multiply_conjugate_32fc(d_conj_buf[pair],
-							in[i], in[j], nread); 
+					volk_32fc_x2_multiply_conjugate_32fc(d_conj_buf[pair].get(),
+							d_in[i], d_in[j], nread);
 				}
-				volk_32fc_magnitude_squared_32f(d_magsq_buf[i], in[i], nread);
+				volk_32fc_magnitude_squared_32f(d_magsq_buf[i].get(), d_in[i], nread);
 			}
 
 			for(int i = 0; i < noutput_items; ++i) {
@@ -24,6 +24,9 @@
 #include <AnyScatter/decimator.h>
 #include <numeric>
 #include <volk/volk.h>
+#include <memory>
+#include <new>
+#include <stdexcept>
 
 namespace gr {
 	namespace AnyScatter {
@@ -38,8 +41,16 @@ namespace gr {
 				const int d_num_pairs;
 				const int d_vlen;
 
-				std::vector<gr_complex*> d_conj_buf;
-				std::vector<float*> d_magsq_buf;
+				struct volk_deleter {
+					void operator()(void *p) const { volk_free(p); }
+				};
+
+				int d_buf_size;
+				std::vector<const gr_complex*> d_in;
+				std::vector<std::unique_ptr<gr_complex[], volk_deleter>> d_conj_buf;
+				std::vector<std::unique_ptr<float[], volk_deleter>> d_magsq_buf;
+
+				static const int BUF_SIZE = 8192;
 
 			public:
 				decimator_impl(int num_antennas, float sample_rate, float symbol_rate);
@@ -44,11 +44,11 @@ namespace gr {
 			d_sps(std::round(symbol_rate / tag_rate)),
 			d_num_antennas(num_antennas),
 			d_num_pairs(num_antennas * (num_antennas - 1) / 2),
-			d_vlen(num_antennas * (num_antennas + 1) / 2)
+			d_vlen(num_antennas * (num_antennas + 1) / 2),
+			d_context(1),
+			d_socket(d_context, ZMQ_PUB)
 		{
-			d_context = new zmq::context_t(1);
-			d_socket = new zmq::socket_t(*d_context, ZMQ_PUB);
-			d_socket->bind("ipc:///tmp/AnyScatterIPC");
+			d_socket.bind("ipc:///tmp/AnyScatterIPC");
 
 			d_sample_buf = std::vector<std::vector<gr_complex>>(d_vlen,
 					std::vector<gr_complex>(d_sps, gr_complex(0.0f, 0.0f)));
@@ -74,9 +74,6 @@ namespace gr {
 
 		demodulator_impl::~demodulator_impl()
 		{
-			d_socket->close();
-			delete d_socket;
-			delete d_context;
 		}
 
 		void demodulator_impl::timing_sync(const int idx, const gr_complex sample)
@@ -201,9 +198,10 @@ namespace gr {
 				res.idx = static_cast<uint16_t>(idx);
 				res.num_antennas = static_cast<uint16_t>(d_num_antennas);
 
+				// the 8-byte body fits in libzmq's inline small-message storage
 				zmq::message_t msg(sizeof(d_zmq_msg));
 				memcpy(msg.data(), &res, sizeof(d_zmq_msg));
-				d_socket->send(msg);
+				d_socket.send(msg);
 			}
 
 		}
@@ -39,8 +39,8 @@ namespace gr {
 				const int d_num_pairs;
 				const int d_vlen;
 
-				zmq::context_t *d_context;
-				zmq::socket_t *d_socket;
+				zmq::context_t d_context;
+				zmq::socket_t d_socket;
 				struct d_zmq_msg {
 					uint8_t data[4];
 					uint16_t idx;
@@ -0,0 +1,196 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Taekyung Kim (tkkim92@korea.ac.kr).
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/attributes.h>
+#include <AnyScatter/decimator.h>
+#include <AnyScatter/demodulator.h>
+#include <boost/test/unit_test.hpp>
+#include <zmq.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+// Count every heap allocation made by the calling thread while armed.
+// Threads owned by libzmq are not counted, only the one running work().
+
+static thread_local bool s_alloc_armed = false;
+static thread_local long s_alloc_count = 0;
+
+static inline void count_alloc()
+{
+	if(s_alloc_armed) ++s_alloc_count;
+}
+
+#ifdef __GLIBC__
+extern "C" {
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t nmemb, size_t size);
+	void *__libc_realloc(void *ptr, size_t size);
+	void __libc_free(void *ptr);
+
+	void *malloc(size_t size) { count_alloc(); return __libc_malloc(size); }
+	void *calloc(size_t nmemb, size_t size) { count_alloc(); return __libc_calloc(nmemb, size); }
+	void *realloc(void *ptr, size_t size) { count_alloc(); return __libc_realloc(ptr, size); }
+	void free(void *ptr) { __libc_free(ptr); }
+}
+#endif
+
+void *operator new(size_t size)
+{
+	count_alloc();
+	if(void *p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+namespace gr {
+	namespace AnyScatter {
+
+		static long count_work_allocs(gr::sync_block *blk, int ncalls, int noutput_items,
+				gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+		{
+			s_alloc_count = 0;
+			s_alloc_armed = true;
+			for(int i = 0; i < ncalls; ++i) {
+				blk->work(noutput_items, input_items, output_items);
+			}
+			s_alloc_armed = false;
+			return s_alloc_count;
+		}
+
+		// Encode 4 bytes the way demodulator_impl::decoding() expects:
+		// each nibble is followed by the complement of its last bit.
+		static std::vector<int> encode_frame(const uint8_t (&bytes)[4])
+		{
+			std::vector<int> bits;
+			for(int i = 0; i < 4; ++i) {
+				for(int half = 0; half < 2; ++half) {
+					for(int j = 0; j < 4; ++j) {
+						bits.push_back((bytes[i] >> (7 - half * 4 - j)) & 1);
+					}
+					bits.push_back(!bits.back());
+				}
+			}
+			return bits;
+		}
+
+		static uint8_t crc8(const uint8_t *data, int len)
+		{
+			uint8_t crc = 0u;
+			for(int i = 0; i < len; ++i) {
+				crc ^= data[i];
+				for(int j = 0; j < 8; ++j) {
+					crc = (crc & 0x80) ? uint8_t((crc << 1) ^ 0x07) : uint8_t(crc << 1);
+				}
+			}
+			return crc;
+		}
+
+		BOOST_AUTO_TEST_CASE(test_decimator_rejects_zero_decimation)
+		{
+			BOOST_CHECK_THROW(decimator::make(2, 1e3f, 1e4f), std::invalid_argument);
+		}
+
+		BOOST_AUTO_TEST_CASE(test_decimator_work_does_not_allocate)
+		{
+			const int num_antennas = 3;
+			const int decim = 100;
+			const int noutput_items = 64;
+			const int vlen = num_antennas * (num_antennas + 1) / 2;
+
+			decimator::sptr dec = decimator::make(num_antennas, 1e6f, 1e6f / decim);
+
+			std::vector<std::vector<gr_complex>> in(num_antennas,
+					std::vector<gr_complex>(noutput_items * decim, gr_complex(0.5f, -0.25f)));
+			std::vector<gr_complex> out(noutput_items * vlen);
+
+			gr_vector_const_void_star input_items;
+			for(auto &v : in) input_items.push_back(v.data());
+			gr_vector_void_star output_items(1, out.data());
+
+			// first call is not steady state
+			dec->work(noutput_items, input_items, output_items);
+
+			BOOST_CHECK_EQUAL(count_work_allocs(dec.get(), 100, noutput_items,
+						input_items, output_items), 0);
+			BOOST_CHECK_CLOSE(out[vlen - 1].real(), decim * 0.3125f, 1e-3);
+		}
+
+		BOOST_AUTO_TEST_CASE(test_demodulator_work_does_not_allocate)
+		{
+			const int sps = 8;
+			uint8_t bytes[4] = {0xA5, 0x3C, 0x96, 0x00};
+			bytes[3] = crc8(bytes, 3);
+
+			// idle alternating bits to lock timing, then the frame
+			std::vector<int> bits;
+			for(int i = 0; i < 40; ++i) bits.push_back(i & 1);
+			std::vector<int> frame = encode_frame(bytes);
+			bits.insert(bits.end(), frame.begin(), frame.end());
+
+			std::vector<gr_complex> in;
+			for(int bit : bits) {
+				in.insert(in.end(), sps, gr_complex(bit ? 1.0f : 0.1f, 0.0f));
+			}
+			const int noutput_items = in.size();
+
+			zmq::context_t context(1);
+			zmq::socket_t sub(context, ZMQ_SUB);
+			const int timeout_ms = 100;
+			sub.setsockopt(ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+			sub.setsockopt(ZMQ_SUBSCRIBE, "", 0);
+
+			demodulator::sptr demod = demodulator::make(1, 1e4f, 1e4f / sps);
+			sub.connect("ipc:///tmp/AnyScatterIPC");
+
+			gr_vector_const_void_star input_items(1, in.data());
+			gr_vector_void_star output_items;
+
+			// warm up until the subscriber is attached and a frame got through
+			zmq::message_t msg;
+			bool received = false;
+			for(int i = 0; i < 50 && !received; ++i) {
+				demod->work(noutput_items, input_items, output_items);
+				received = sub.recv(&msg);
+			}
+			BOOST_REQUIRE(received);
+			while(sub.recv(&msg)) {}
+
+			BOOST_CHECK_EQUAL(count_work_allocs(demod.get(), 3, noutput_items,
+						input_items, output_items), 0);
+
+			BOOST_REQUIRE(sub.recv(&msg));
+			BOOST_REQUIRE_EQUAL(msg.size(), 8u);
+			BOOST_CHECK_EQUAL(memcmp(msg.data(), bytes, sizeof(bytes)), 0);
+		}
+
+	} /* namespace AnyScatter */
+} /* namespace gr */